@@ -0,0 +1,69 @@
+#include "combinations.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace poker {
+
+using ::std::vector;
+
+uint64_t Choose(int n, int k) {
+  if (k < 0 || k > n) {
+    return 0;
+  }
+  uint64_t result = 1;
+  for (int i = 1; i <= k; ++i) {
+    result = result * (n - k + i) / i;
+  }
+  return result;
+}
+
+bool NextCombination(vector<int> *indices, int n) {
+  const int k = indices->size();
+  int i = k - 1;
+  while (i >= 0 && (*indices)[i] == n - k + i) {
+    --i;
+  }
+  if (i < 0) {
+    return false;
+  }
+  ++(*indices)[i];
+  for (int j = i + 1; j < k; ++j) {
+    (*indices)[j] = (*indices)[j - 1] + 1;
+  }
+  return true;
+}
+
+uint64_t ColexRank(const vector<int> &indices) {
+  uint64_t rank = 0;
+  for (size_t j = 0; j < indices.size(); ++j) {
+    rank += Choose(indices[j], j + 1);
+  }
+  return rank;
+}
+
+vector<int> ColexUnrank(uint64_t rank, int k) {
+  vector<int> indices(k);
+  for (int j = k; j > 0; --j) {
+    // Largest c with C(c, j) <= rank.
+    int c = j - 1;
+    while (Choose(c + 1, j) <= rank) {
+      ++c;
+    }
+    indices[j - 1] = c;
+    rank -= Choose(c, j);
+  }
+  return indices;
+}
+
+uint64_t ScatterStep(uint64_t total) {
+  uint64_t step = total * 0.618 + 1;
+  while (std::gcd(step, total) != 1) {
+    ++step;
+  }
+  return step;
+}
+
+}  // namespace poker
@@ -0,0 +1,29 @@
+#ifndef COMBINATIONS
+#define COMBINATIONS
+
+#include <cstdint>
+#include <vector>
+
+namespace poker {
+
+// Number of ways to pick k of n items.
+uint64_t Choose(int n, int k);
+
+// Advances `indices` to the next increasing combination of values below
+// `n`. Returns false once the last combination has been passed.
+bool NextCombination(std::vector<int> *indices, int n);
+
+// Colexicographic rank of an increasing combination, which is dense in
+// [0, C(n, k)) for combinations of k values below n.
+uint64_t ColexRank(const std::vector<int> &indices);
+
+// Inverse of ColexRank for combinations of size k.
+std::vector<int> ColexUnrank(uint64_t rank, int k);
+
+// Returns a step coprime with `total`, so that i * step % total for i in
+// [0, total) visits every index once while jumping around the whole range.
+uint64_t ScatterStep(uint64_t total);
+
+}  // namespace poker
+
+#endif // COMBINATIONS
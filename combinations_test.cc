@@ -0,0 +1,55 @@
+#include "combinations.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace poker {
+namespace {
+
+TEST(CombinationsTest, Choose) {
+  EXPECT_EQ(Choose(48, 3), 17296u);
+  EXPECT_EQ(Choose(48, 5), 1712304u);
+  EXPECT_EQ(Choose(5, 0), 1u);
+  EXPECT_EQ(Choose(3, 5), 0u);
+}
+
+TEST(CombinationsTest, UnrankInvertsRank) {
+  for (int k = 1; k <= 5; ++k) {
+    std::vector<int> indices(k);
+    for (int i = 0; i < k; ++i) {
+      indices[i] = i;
+    }
+    uint64_t count = 0;
+    do {
+      const uint64_t rank = ColexRank(indices);
+      ASSERT_LT(rank, Choose(48, k));
+      ASSERT_EQ(ColexUnrank(rank, k), indices) << "k = " << k;
+      ++count;
+    } while (NextCombination(&indices, 48));
+    EXPECT_EQ(count, Choose(48, k));
+  }
+}
+
+TEST(CombinationsTest, ScatterStepVisitsEveryIndexOnce) {
+  std::vector<uint64_t> totals;
+  for (uint64_t total = 1; total <= 500; ++total) {
+    totals.push_back(total);
+  }
+  totals.push_back(Choose(48, 2));
+  totals.push_back(Choose(48, 5));
+
+  for (const uint64_t total : totals) {
+    const uint64_t step = ScatterStep(total);
+    std::vector<bool> visited(total);
+    for (uint64_t i = 0; i < total; ++i) {
+      const uint64_t index = i * step % total;
+      ASSERT_FALSE(visited[index]) << "total = " << total;
+      visited[index] = true;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace poker
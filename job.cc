@@ -0,0 +1,161 @@
+#include "job.h"
+
+#include <cstdint>
+#include <future>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "combinations.h"
+
+namespace poker {
+
+using ::absl::InvalidArgumentError;
+using ::absl::StatusCode;
+using ::absl::StatusOr;
+using ::absl::StrCat;
+using ::std::pair;
+using ::std::vector;
+
+namespace {
+
+// Keeps the running tally of a job and decides when it has to stop.
+class Tally {
+ public:
+  Tally(uint64_t total, const EquityJobOptions &options)
+      : options_(options), last_report_(absl::Now()) {
+    result_.total = total;
+  }
+
+  // Returns false, and records why, if the job should stop before the next
+  // sample.
+  bool KeepGoing() {
+    if (options_.cancel != nullptr && options_.cancel->IsCancelled()) {
+      result_.code = StatusCode::kCancelled;
+      return false;
+    }
+    const absl::Time now = absl::Now();
+    if (now >= options_.deadline) {
+      result_.code = StatusCode::kDeadlineExceeded;
+      return false;
+    }
+    if (options_.on_progress && result_.samples > 0 &&
+        now - last_report_ >= options_.progress_interval) {
+      last_report_ = now;
+      options_.on_progress(Result());
+    }
+    return true;
+  }
+
+  void Record(int compare) {
+    wins_ += compare == -1 ? 1 : 0;
+    ties_ += compare == 0 ? 1 : 0;
+    ++result_.samples;
+  }
+
+  EquityResult Result() const {
+    EquityResult result = result_;
+    if (result.samples > 0) {
+      result.win = static_cast<double>(wins_) / result.samples;
+      result.tie = static_cast<double>(ties_) / result.samples;
+    }
+    return result;
+  }
+
+  EquityResult Finish() const {
+    const EquityResult result = Result();
+    if (options_.on_progress) {
+      options_.on_progress(result);
+    }
+    return result;
+  }
+
+ private:
+  const EquityJobOptions &options_;
+  absl::Time last_report_;
+  uint64_t wins_ = 0;
+  uint64_t ties_ = 0;
+  EquityResult result_;
+};
+
+}  // namespace
+
+StatusOr<EquityResult> RunWinPercentage(int n, const pair<Card, Card> &self,
+                                        const pair<Card, Card> &opponent,
+                                        const vector<Card> &board,
+                                        const EquityJobOptions &options) {
+  if (n < 0) {
+    return InvalidArgumentError(StrCat("Negative n: ", n));
+  }
+  if (board.size() != 0 && (board.size() < 3 || board.size() > 5)) {
+    return InvalidArgumentError(StrCat("Bad board size: ", board.size()));
+  }
+  vector<Card> deck = GetAllPossibleCards();
+  for (const auto &card : {self.first, self.second, opponent.first,
+                           opponent.second}) {
+    if (!DeleteCard(&deck, card).ok()) {
+      return InvalidArgumentError(
+          StrCat("Invalid or duplicate card: ", DebugString(card)));
+    }
+  }
+  for (const auto &card : board) {
+    if (!DeleteCard(&deck, card).ok()) {
+      return InvalidArgumentError(
+          StrCat("Invalid or duplicate card: ", DebugString(card)));
+    }
+  }
+
+  const int runout_size = 5 - board.size();
+  const uint64_t total = n > 0 ? n : Choose(deck.size(), runout_size);
+  Tally tally(total, options);
+  vector<Card> full_board = board;
+
+  if (n > 0) {
+    std::mt19937 gen(std::random_device{}());
+    vector<int> order(deck.size());
+    std::iota(order.begin(), order.end(), 0);
+    for (uint64_t i = 0; i < total && tally.KeepGoing(); ++i) {
+      full_board.erase(full_board.begin() + board.size(), full_board.end());
+      // Partial shuffle: the first runout_size entries are the runout.
+      for (int j = 0; j < runout_size; ++j) {
+        std::uniform_int_distribution<int> pick(j, order.size() - 1);
+        std::swap(order[j], order[pick(gen)]);
+        full_board.push_back(deck[order[j]]);
+      }
+      const StatusOr<int> compare = CompareHands(self, opponent, full_board);
+      if (!compare.ok()) {
+        return compare.status();
+      }
+      tally.Record(*compare);
+    }
+    return tally.Finish();
+  }
+
+  const uint64_t step = ScatterStep(total);
+  for (uint64_t i = 0; i < total && tally.KeepGoing(); ++i) {
+    full_board.erase(full_board.begin() + board.size(), full_board.end());
+    for (const int index : ColexUnrank(i * step % total, runout_size)) {
+      full_board.push_back(deck[index]);
+    }
+    const StatusOr<int> compare = CompareHands(self, opponent, full_board);
+    if (!compare.ok()) {
+      return compare.status();
+    }
+    tally.Record(*compare);
+  }
+  return tally.Finish();
+}
+
+std::future<StatusOr<EquityResult>> StartWinPercentage(
+    int n, const pair<Card, Card> &self, const pair<Card, Card> &opponent,
+    const vector<Card> &board, EquityJobOptions options) {
+  return std::async(
+      std::launch::async,
+      [n, self, opponent, board, options = std::move(options)] {
+        return RunWinPercentage(n, self, opponent, board, options);
+      });
+}
+
+}  // namespace poker
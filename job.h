@@ -0,0 +1,76 @@
+#ifndef JOB
+#define JOB
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "table.h"
+
+namespace poker {
+
+// Lets a caller stop a running job from another thread.
+class CancellationToken {
+ public:
+  void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+  bool IsCancelled() const {
+    return cancelled_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<bool> cancelled_{false};
+};
+
+// Odds over the boards evaluated so far. For a job that finished, `samples`
+// equals `total` and the odds are the same as WinPercentage's.
+struct EquityResult {
+  double win = 0;
+  double tie = 0;
+  uint64_t samples = 0;
+  // Monte-Carlo trials requested, or the number of runouts for exact odds.
+  uint64_t total = 0;
+  // kOk if the job ran to completion, otherwise kCancelled or
+  // kDeadlineExceeded and the result is partial.
+  absl::StatusCode code = absl::StatusCode::kOk;
+};
+
+struct EquityJobOptions {
+  absl::Time deadline = absl::InfiniteFuture();
+  // May be null.
+  std::shared_ptr<CancellationToken> cancel;
+  // Called from the job's thread with the running estimate, at most once per
+  // `progress_interval`, and once more with the final result.
+  std::function<void(const EquityResult &)> on_progress;
+  absl::Duration progress_interval = absl::Milliseconds(100);
+};
+
+// Same as WinPercentage, but stops early when the deadline passes or the
+// token is cancelled and returns what it has so far. Pass n = 0 for exact
+// odds; runouts are then visited in a scattered order so a partial result is
+// an estimate over the whole board space rather than a corner of it.
+absl::StatusOr<EquityResult> RunWinPercentage(
+    int n, const std::pair<Card, Card> &self,
+    const std::pair<Card, Card> &opponent, const std::vector<Card> &board,
+    const EquityJobOptions &options);
+
+// Runs RunWinPercentage on its own thread.
+//
+// The future comes from std::async, so its destructor blocks until the job
+// is done. Dropping it does not detach the job: to abandon one, cancel it
+// first and expect the destructor to wait for the job to notice, which takes
+// at most one more board.
+std::future<absl::StatusOr<EquityResult>> StartWinPercentage(
+    int n, const std::pair<Card, Card> &self,
+    const std::pair<Card, Card> &opponent, const std::vector<Card> &board,
+    EquityJobOptions options);
+
+}  // namespace poker
+
+#endif // JOB
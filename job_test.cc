@@ -0,0 +1,84 @@
+#include "job.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+#include "table.h"
+
+namespace poker {
+namespace {
+
+const std::pair<Card, Card> kAces = {Card(Suit(0), Rank(12)),
+                                     Card(Suit(1), Rank(12))};
+const std::pair<Card, Card> kSevenDeuce = {Card(Suit(2), Rank(0)),
+                                           Card(Suit(3), Rank(5))};
+
+void ExpectMatchesWinPercentage(const std::vector<Card> &board,
+                                uint64_t total) {
+  const auto result =
+      RunWinPercentage(0, kAces, kSevenDeuce, board, EquityJobOptions());
+  ASSERT_TRUE(result.ok()) << result.status();
+  const auto odds = WinPercentage(kAces, kSevenDeuce, board);
+  ASSERT_TRUE(odds.ok()) << odds.status();
+
+  EXPECT_EQ(result->code, absl::StatusCode::kOk);
+  EXPECT_EQ(result->samples, total);
+  EXPECT_EQ(result->total, total);
+  EXPECT_DOUBLE_EQ(result->win, odds->first);
+  EXPECT_DOUBLE_EQ(result->tie, odds->second);
+}
+
+TEST(JobTest, ExactMatchesWinPercentageOnFlop) {
+  ExpectMatchesWinPercentage({Card(Suit(3), Rank(0)), Card(Suit(1), Rank(5)),
+                              Card(Suit(2), Rank(5))},
+                             990);
+}
+
+TEST(JobTest, ExactMatchesWinPercentageOnTurn) {
+  ExpectMatchesWinPercentage({Card(Suit(0), Rank(7)), Card(Suit(1), Rank(5)),
+                              Card(Suit(2), Rank(9)), Card(Suit(3), Rank(1))},
+                             44);
+}
+
+TEST(JobTest, CancelReturnsPartialResult) {
+  auto cancel = std::make_shared<CancellationToken>();
+  EquityJobOptions options;
+  options.cancel = cancel;
+  options.progress_interval = absl::ZeroDuration();
+  // Cancel from the progress callback once a few boards are in.
+  options.on_progress = [&cancel](const EquityResult &progress) {
+    if (progress.samples >= 2000) {
+      cancel->Cancel();
+    }
+  };
+
+  const auto result = StartWinPercentage(0, kAces, kSevenDeuce, {}, options)
+                          .get();
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_EQ(result->code, absl::StatusCode::kCancelled);
+  EXPECT_GE(result->samples, 2000u);
+  EXPECT_LT(result->samples, result->total);
+  // Runouts are scattered, so a small sample is already close to 87.24%.
+  EXPECT_NEAR(result->win, 0.8724, 0.03);
+}
+
+TEST(JobTest, DeadlineReturnsPartialResult) {
+  EquityJobOptions options;
+  options.deadline = absl::Now() + absl::Milliseconds(50);
+  const auto result =
+      RunWinPercentage(10000000, kAces, kSevenDeuce, {}, options);
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_EQ(result->code, absl::StatusCode::kDeadlineExceeded);
+  EXPECT_LT(result->samples, result->total);
+  EXPECT_EQ(result->total, 10000000u);
+}
+
+TEST(JobTest, RejectsDuplicateCards) {
+  EXPECT_FALSE(RunWinPercentage(0, kAces, kAces, {}, EquityJobOptions()).ok());
+}
+
+}  // namespace
+}  // namespace poker
@@ -0,0 +1,182 @@
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "protocol.h"
+#include "table.h"
+
+ABSL_FLAG(std::string, socket, "/tmp/poker.sock",
+          "Path of the equity server's Unix domain socket.");
+ABSL_FLAG(int, connections, 8, "Number of concurrent client connections.");
+ABSL_FLAG(int, requests, 1000, "Number of requests sent per connection.");
+ABSL_FLAG(int, distinct, 100,
+          "Number of distinct random matchups to draw requests from. Lower "
+          "values exercise request coalescing and the cache.");
+ABSL_FLAG(int, board_size, 3, "Number of board cards in each matchup.");
+ABSL_FLAG(int, n, 0, "Monte-Carlo trials per request, or 0 for exact odds.");
+ABSL_FLAG(int, deadline_ms, 0,
+          "Deadline sent with each request, or 0 for none. Requests that run "
+          "out of time are answered with partial odds.");
+ABSL_FLAG(int, seed, 1, "Seed for generating matchups.");
+
+namespace poker {
+
+using Clock = std::chrono::steady_clock;
+
+absl::StatusOr<int> Connect(const std::string &path) {
+  const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return absl::InternalError(
+        absl::StrCat("socket failed: ", strerror(errno)));
+  }
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+    const std::string error = strerror(errno);
+    close(fd);
+    return absl::UnavailableError(
+        absl::StrCat("Failed to connect to ", path, ": ", error));
+  }
+  return fd;
+}
+
+std::vector<EquityRequest> MakeMatchups(int count, int board_size, int n,
+                                        int deadline_ms, int seed) {
+  std::mt19937 gen(seed);
+  std::vector<EquityRequest> matchups;
+  for (int i = 0; i < count; ++i) {
+    std::vector<uint8_t> deck(52);
+    std::iota(deck.begin(), deck.end(), 0);
+    std::shuffle(deck.begin(), deck.end(), gen);
+    EquityRequest request;
+    request.n = n;
+    request.deadline_ms = deadline_ms;
+    for (int j = 0; j < 4 + board_size; ++j) {
+      request.cards.push_back(*DecodeCard(deck[j]));
+    }
+    matchups.push_back(request);
+  }
+  return matchups;
+}
+
+// Sends requests one at a time and records each round trip in microseconds.
+absl::Status RunConnection(const std::vector<EquityRequest> &matchups,
+                           int requests, int seed,
+                           std::vector<double> *latencies, int *partial) {
+  absl::StatusOr<int> fd = Connect(absl::GetFlag(FLAGS_socket));
+  if (!fd.ok()) {
+    return fd.status();
+  }
+  std::mt19937 gen(seed);
+  absl::Status status;
+  for (int i = 0; i < requests && status.ok(); ++i) {
+    EquityRequest request = matchups[gen() % matchups.size()];
+    request.request_id = i;
+
+    const auto start = Clock::now();
+    status = WriteFrame(*fd, EncodeRequest(request));
+    if (!status.ok()) {
+      break;
+    }
+    absl::StatusOr<std::string> payload = ReadFrame(*fd);
+    if (!payload.ok()) {
+      status = payload.status();
+      break;
+    }
+    latencies->push_back(
+        std::chrono::duration<double, std::micro>(Clock::now() - start)
+            .count());
+
+    absl::StatusOr<EquityResponse> response = DecodeResponse(*payload);
+    if (!response.ok()) {
+      status = response.status();
+    } else if (response->request_id != request.request_id) {
+      status = absl::InternalError("Response id mismatch");
+    } else if (response->code == absl::StatusCode::kDeadlineExceeded) {
+      ++*partial;
+    } else if (response->code != absl::StatusCode::kOk) {
+      status = absl::Status(response->code, "Server rejected request");
+    }
+  }
+  close(*fd);
+  return status;
+}
+
+double Percentile(const std::vector<double> &sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  return sorted[std::min(sorted.size() - 1,
+                         static_cast<size_t>(p * sorted.size()))];
+}
+
+}  // namespace poker
+
+int main(int argc, char* argv[]) {
+  absl::ParseCommandLine(argc, argv);
+  const int board_size = absl::GetFlag(FLAGS_board_size);
+  if (board_size != 0 && (board_size < 3 || board_size > 5)) {
+    std::cout << "Bad board size: " << board_size << std::endl;
+    return 1;
+  }
+
+  const std::vector<poker::EquityRequest> matchups = poker::MakeMatchups(
+      std::max(1, absl::GetFlag(FLAGS_distinct)), board_size,
+      absl::GetFlag(FLAGS_n), absl::GetFlag(FLAGS_deadline_ms),
+      absl::GetFlag(FLAGS_seed));
+  const int connections = absl::GetFlag(FLAGS_connections);
+  std::vector<std::vector<double>> latencies(connections);
+  std::vector<absl::Status> statuses(connections);
+  std::vector<int> partial(connections);
+  std::vector<std::thread> threads;
+
+  const auto start = poker::Clock::now();
+  for (int i = 0; i < connections; ++i) {
+    threads.emplace_back([&, i] {
+      statuses[i] = poker::RunConnection(
+          matchups, absl::GetFlag(FLAGS_requests),
+          absl::GetFlag(FLAGS_seed) + i + 1, &latencies[i], &partial[i]);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  const double seconds =
+      std::chrono::duration<double>(poker::Clock::now() - start).count();
+
+  std::vector<double> all;
+  for (const auto &latency : latencies) {
+    all.insert(all.end(), latency.begin(), latency.end());
+  }
+  std::sort(all.begin(), all.end());
+  for (const auto &status : statuses) {
+    if (!status.ok()) {
+      std::cout << "Error: " << status.message() << std::endl;
+    }
+  }
+
+  std::cout << "Requests: " << all.size() << std::endl;
+  std::cout << "Partial: " << std::accumulate(partial.begin(), partial.end(), 0)
+            << std::endl;
+  std::cout << "Throughput: " << all.size() / seconds << " req/s" << std::endl;
+  std::cout << "p50: " << poker::Percentile(all, 0.5) << " us" << std::endl;
+  std::cout << "p99: " << poker::Percentile(all, 0.99) << " us" << std::endl;
+  return 0;
+}
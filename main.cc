@@ -5,7 +5,6 @@
 #include <string>
 #include <utility>
 #include <vector>
-#include <set>
 
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
@@ -27,33 +26,6 @@ ABSL_FLAG(int, n, 0, "If set, odds will be calculated using n trials");
 
 namespace poker {
 
-absl::StatusOr<Card> MapCardString(const std::string &card) {
-  const std::pair<std::string, std::string> pair_str =
-      absl::StrSplit(card, ',', absl::SkipEmpty());
-
-  const std::string suit_str = pair_str.first;
-  const std::set<std::string> possible_suits({"s", "h", "d", "c"});
-  if (possible_suits.find(suit_str) == possible_suits.end()) {
-      return absl::InvalidArgumentError(
-          absl::StrCat("Invalid suit", suit_str));
-  }
-
-  const Suit suit(suit_str == "s"   ? Suit(0)
-                  : suit_str == "h" ? Suit(1)
-                  : suit_str == "d" ? Suit(2)
-                  : suit_str == "c" ? Suit(3) : Suit(4)); // Impossible
-  
-  int rank_num;
-   // Parse the string into an integer.
-  const std::string &rank_str = pair_str.second;
-  if (!absl::SimpleAtoi(rank_str, &rank_num)) {
-      return absl::InvalidArgumentError(
-          absl::StrCat("Invalid rank", rank_str));
-  }
-
-  return Card(suit, Rank(rank_num - 2));
-}
-
 absl::StatusOr<std::pair<double, double>> GetOdds() {
     const std::vector<std::string> self_str =
      absl::StrSplit(absl::GetFlag(FLAGS_self), ';');
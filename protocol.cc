@@ -0,0 +1,196 @@
+#include "protocol.h"
+
+#include <errno.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+
+namespace poker {
+
+using ::absl::InvalidArgumentError;
+using ::absl::OkStatus;
+using ::absl::Status;
+using ::absl::StatusOr;
+using ::absl::StrCat;
+using ::absl::string_view;
+using ::std::string;
+using ::std::vector;
+
+namespace {
+
+template <typename T>
+void Append(string *out, const T &value) {
+  out->append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+bool Consume(string_view *in, T *value) {
+  if (in->size() < sizeof(T)) {
+    return false;
+  }
+  std::memcpy(value, in->data(), sizeof(T));
+  in->remove_prefix(sizeof(T));
+  return true;
+}
+
+Status ReadFull(int fd, char *buf, size_t size) {
+  size_t done = 0;
+  while (done < size) {
+    const ssize_t got = read(fd, buf + done, size - done);
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got < 0) {
+      return absl::InternalError(StrCat("read failed: ", strerror(errno)));
+    }
+    if (got == 0) {
+      return done == 0 ? absl::OutOfRangeError("EOF")
+                       : absl::DataLossError("Truncated frame");
+    }
+    done += got;
+  }
+  return OkStatus();
+}
+
+Status WriteFull(int fd, const char *buf, size_t size) {
+  size_t done = 0;
+  while (done < size) {
+    // MSG_NOSIGNAL so a client hanging up doesn't kill the server.
+    const ssize_t put = send(fd, buf + done, size - done, MSG_NOSIGNAL);
+    if (put < 0 && errno == EINTR) {
+      continue;
+    }
+    if (put < 0) {
+      return absl::InternalError(StrCat("send failed: ", strerror(errno)));
+    }
+    done += put;
+  }
+  return OkStatus();
+}
+
+}  // namespace
+
+string EncodeRequest(const EquityRequest &request) {
+  string out;
+  Append(&out, request.request_id);
+  Append(&out, request.n);
+  Append(&out, request.deadline_ms);
+  Append(&out, static_cast<uint8_t>(request.cards.size() - 4));
+  for (const auto &card : request.cards) {
+    Append(&out, EncodeCard(card));
+  }
+  return out;
+}
+
+StatusOr<EquityRequest> DecodeRequest(string_view payload) {
+  EquityRequest request;
+  uint8_t board_size;
+  if (!Consume(&payload, &request.request_id) ||
+      !Consume(&payload, &request.n) ||
+      !Consume(&payload, &request.deadline_ms) ||
+      !Consume(&payload, &board_size)) {
+    return InvalidArgumentError("Truncated request header");
+  }
+  if (request.n < 0) {
+    return InvalidArgumentError(StrCat("Negative n: ", request.n));
+  }
+  if (board_size != 0 && (board_size < 3 || board_size > 5)) {
+    return InvalidArgumentError(StrCat("Bad board size: ", board_size));
+  }
+  if (payload.size() != 4u + board_size) {
+    return InvalidArgumentError(
+        StrCat("Expected ", 4 + board_size, " cards, got ", payload.size()));
+  }
+
+  vector<uint8_t> seen;
+  for (const char c : payload) {
+    const uint8_t byte = static_cast<uint8_t>(c);
+    StatusOr<Card> card = DecodeCard(byte);
+    if (!card.ok()) {
+      return card.status();
+    }
+    if (find(seen.begin(), seen.end(), byte) != seen.end()) {
+      return InvalidArgumentError(
+          StrCat("Duplicate card: ", DebugString(*card)));
+    }
+    seen.push_back(byte);
+    request.cards.push_back(*card);
+  }
+  return request;
+}
+
+string EncodeResponse(const EquityResponse &response) {
+  string out;
+  Append(&out, response.request_id);
+  Append(&out, static_cast<uint8_t>(response.code));
+  Append(&out, response.win);
+  Append(&out, response.tie);
+  Append(&out, response.samples);
+  return out;
+}
+
+StatusOr<EquityResponse> DecodeResponse(string_view payload) {
+  EquityResponse response;
+  uint8_t code;
+  if (!Consume(&payload, &response.request_id) || !Consume(&payload, &code) ||
+      !Consume(&payload, &response.win) || !Consume(&payload, &response.tie) ||
+      !Consume(&payload, &response.samples) || !payload.empty()) {
+    return InvalidArgumentError("Malformed response");
+  }
+  response.code = static_cast<absl::StatusCode>(code);
+  return response;
+}
+
+string CanonicalKey(const EquityRequest &request) {
+  vector<uint8_t> self = {EncodeCard(request.cards[0]),
+                          EncodeCard(request.cards[1])};
+  vector<uint8_t> opponent = {EncodeCard(request.cards[2]),
+                              EncodeCard(request.cards[3])};
+  vector<uint8_t> board;
+  for (size_t i = 4; i < request.cards.size(); ++i) {
+    board.push_back(EncodeCard(request.cards[i]));
+  }
+  sort(self.begin(), self.end());
+  sort(opponent.begin(), opponent.end());
+  sort(board.begin(), board.end());
+
+  string key;
+  Append(&key, request.n);
+  key.append(self.begin(), self.end());
+  key.append(opponent.begin(), opponent.end());
+  key.append(board.begin(), board.end());
+  return key;
+}
+
+Status WriteFrame(int fd, string_view payload) {
+  string frame;
+  Append(&frame, static_cast<uint32_t>(payload.size()));
+  frame.append(payload.data(), payload.size());
+  return WriteFull(fd, frame.data(), frame.size());
+}
+
+StatusOr<string> ReadFrame(int fd) {
+  uint32_t size;
+  Status status = ReadFull(fd, reinterpret_cast<char *>(&size), sizeof(size));
+  if (!status.ok()) {
+    return status;
+  }
+  if (size > kMaxFrameSize) {
+    return InvalidArgumentError(StrCat("Frame too large: ", size));
+  }
+  string payload(size, '\0');
+  status = ReadFull(fd, &payload[0], size);
+  if (!status.ok()) {
+    return status;
+  }
+  return payload;
+}
+
+}  // namespace poker
@@ -0,0 +1,83 @@
+#ifndef PROTOCOL
+#define PROTOCOL
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "table.h"
+
+namespace poker {
+
+// Wire format used by the equity server over a Unix domain socket. Every
+// message is a frame: a uint32 payload length followed by the payload. All
+// integers are in host byte order since both ends live on the same machine.
+//
+// Request payload:
+//   uint32 request_id
+//   int32  n            (0 for exact odds, otherwise Monte-Carlo trials)
+//   uint32 deadline_ms  (0 for no deadline)
+//   uint8  board_size   (0, 3, 4 or 5)
+//   uint8  cards[4 + board_size]
+//          (self.first, self.second, opponent.first, opponent.second, board)
+//
+// Response payload:
+//   uint32 request_id
+//   uint8  code         (absl::StatusCode)
+//   double win
+//   double tie
+//   uint64 samples      (boards evaluated to get win and tie)
+//
+// A code of kDeadlineExceeded means the odds are partial, estimated from
+// `samples` boards.
+//
+// Cards are encoded with EncodeCard() from table.h.
+
+// Frames larger than this are rejected as malformed.
+constexpr uint32_t kMaxFrameSize = 1 << 12;
+
+struct EquityRequest {
+  uint32_t request_id = 0;
+  int32_t n = 0;
+  uint32_t deadline_ms = 0;
+  std::vector<Card> cards;  // Both hands followed by the board.
+
+  std::pair<Card, Card> Self() const { return {cards[0], cards[1]}; }
+  std::pair<Card, Card> Opponent() const { return {cards[2], cards[3]}; }
+  std::vector<Card> Board() const {
+    return std::vector<Card>(cards.begin() + 4, cards.end());
+  }
+};
+
+struct EquityResponse {
+  uint32_t request_id = 0;
+  absl::StatusCode code = absl::StatusCode::kOk;
+  double win = 0;
+  double tie = 0;
+  uint64_t samples = 0;
+};
+
+std::string EncodeRequest(const EquityRequest &request);
+// Also checks that the cards are valid, distinct and the board has a legal
+// size.
+absl::StatusOr<EquityRequest> DecodeRequest(absl::string_view payload);
+
+std::string EncodeResponse(const EquityResponse &response);
+absl::StatusOr<EquityResponse> DecodeResponse(absl::string_view payload);
+
+// Returns a key identifying the equity a request asks for, independent of
+// its id and deadline, and of the order of cards within each hand and on the
+// board.
+std::string CanonicalKey(const EquityRequest &request);
+
+// Blocking frame IO. ReadFrame returns OutOfRangeError on a clean EOF.
+absl::Status WriteFrame(int fd, absl::string_view payload);
+absl::StatusOr<std::string> ReadFrame(int fd);
+
+}  // namespace poker
+
+#endif // PROTOCOL
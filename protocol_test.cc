@@ -0,0 +1,159 @@
+#include "protocol.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "table.h"
+
+namespace poker {
+namespace {
+
+EquityRequest MakeRequest(const std::vector<int> &cards) {
+  EquityRequest request;
+  request.request_id = 7;
+  request.n = 1000;
+  request.deadline_ms = 50;
+  for (const int card : cards) {
+    request.cards.push_back(*DecodeCard(card));
+  }
+  return request;
+}
+
+// A connected pair of sockets, closed on destruction.
+class SocketPair {
+ public:
+  SocketPair() { EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds_), 0); }
+  ~SocketPair() {
+    close(fds_[0]);
+    close(fds_[1]);
+  }
+
+  int reader() const { return fds_[0]; }
+  int writer() const { return fds_[1]; }
+
+ private:
+  int fds_[2];
+};
+
+TEST(ProtocolTest, RequestRoundTrip) {
+  for (const auto &cards : std::vector<std::vector<int>>{
+           {12, 25, 0, 18}, {12, 25, 0, 18, 3, 4, 5},
+           {12, 25, 0, 18, 3, 4, 5, 6, 51}}) {
+    const EquityRequest request = MakeRequest(cards);
+    const auto decoded = DecodeRequest(EncodeRequest(request));
+    ASSERT_TRUE(decoded.ok()) << decoded.status();
+    EXPECT_EQ(decoded->request_id, request.request_id);
+    EXPECT_EQ(decoded->n, request.n);
+    EXPECT_EQ(decoded->deadline_ms, request.deadline_ms);
+    ASSERT_EQ(decoded->cards.size(), cards.size());
+    for (size_t i = 0; i < cards.size(); ++i) {
+      EXPECT_EQ(EncodeCard(decoded->cards[i]), cards[i]);
+    }
+  }
+}
+
+TEST(ProtocolTest, ResponseRoundTrip) {
+  EquityResponse response;
+  response.request_id = 42;
+  response.code = absl::StatusCode::kDeadlineExceeded;
+  response.win = 0.8724;
+  response.tie = 0.0036;
+  response.samples = 1712304;
+
+  const auto decoded = DecodeResponse(EncodeResponse(response));
+  ASSERT_TRUE(decoded.ok()) << decoded.status();
+  EXPECT_EQ(decoded->request_id, response.request_id);
+  EXPECT_EQ(decoded->code, response.code);
+  EXPECT_EQ(decoded->win, response.win);
+  EXPECT_EQ(decoded->tie, response.tie);
+  EXPECT_EQ(decoded->samples, response.samples);
+
+  EXPECT_FALSE(DecodeResponse(EncodeResponse(response) + "x").ok());
+}
+
+TEST(ProtocolTest, RejectsBadRequests) {
+  const std::string valid =
+      EncodeRequest(MakeRequest({12, 25, 0, 18, 3, 4, 5}));
+  ASSERT_TRUE(DecodeRequest(valid).ok());
+
+  // Header is request_id, n, deadline_ms and board_size.
+  const size_t header_size = 13;
+  EXPECT_FALSE(DecodeRequest(valid.substr(0, header_size - 1)).ok());
+  // A missing card.
+  EXPECT_FALSE(DecodeRequest(valid.substr(0, valid.size() - 1)).ok());
+
+  std::string bad_board_size = valid;
+  bad_board_size[header_size - 1] = 2;
+  EXPECT_FALSE(DecodeRequest(bad_board_size).ok());
+
+  EXPECT_FALSE(
+      DecodeRequest(EncodeRequest(MakeRequest({12, 25, 0, 12}))).ok());
+  EXPECT_FALSE(
+      DecodeRequest(EncodeRequest(MakeRequest({12, 25, 0, 18, 3, 4, 25})))
+          .ok());
+
+  std::string bad_card = valid;
+  bad_card.back() = 52;
+  EXPECT_FALSE(DecodeRequest(bad_card).ok());
+
+  EquityRequest negative = MakeRequest({12, 25, 0, 18});
+  negative.n = -1;
+  EXPECT_FALSE(DecodeRequest(EncodeRequest(negative)).ok());
+}
+
+TEST(ProtocolTest, FrameRoundTrip) {
+  SocketPair sockets;
+  ASSERT_TRUE(WriteFrame(sockets.writer(), "hello").ok());
+  ASSERT_TRUE(WriteFrame(sockets.writer(), "").ok());
+
+  auto frame = ReadFrame(sockets.reader());
+  ASSERT_TRUE(frame.ok()) << frame.status();
+  EXPECT_EQ(*frame, "hello");
+  frame = ReadFrame(sockets.reader());
+  ASSERT_TRUE(frame.ok()) << frame.status();
+  EXPECT_EQ(*frame, "");
+
+  shutdown(sockets.writer(), SHUT_WR);
+  EXPECT_TRUE(absl::IsOutOfRange(ReadFrame(sockets.reader()).status()));
+}
+
+TEST(ProtocolTest, RejectsOversizedFrame) {
+  SocketPair sockets;
+  const uint32_t size = kMaxFrameSize + 1;
+  ASSERT_EQ(write(sockets.writer(), &size, sizeof(size)),
+            static_cast<ssize_t>(sizeof(size)));
+  EXPECT_TRUE(absl::IsInvalidArgument(ReadFrame(sockets.reader()).status()));
+}
+
+TEST(ProtocolTest, RejectsTruncatedFrame) {
+  SocketPair sockets;
+  const uint16_t half_size = 5;
+  ASSERT_EQ(write(sockets.writer(), &half_size, sizeof(half_size)),
+            static_cast<ssize_t>(sizeof(half_size)));
+  shutdown(sockets.writer(), SHUT_WR);
+  EXPECT_TRUE(absl::IsDataLoss(ReadFrame(sockets.reader()).status()));
+}
+
+TEST(ProtocolTest, CanonicalKeyIgnoresCardOrder) {
+  const EquityRequest request = MakeRequest({12, 25, 0, 18, 3, 4, 5});
+  EquityRequest reordered = MakeRequest({25, 12, 18, 0, 5, 3, 4});
+  reordered.request_id = 8;
+  reordered.deadline_ms = 0;
+  EXPECT_EQ(CanonicalKey(request), CanonicalKey(reordered));
+
+  // The hands are not interchangeable.
+  EXPECT_NE(CanonicalKey(request),
+            CanonicalKey(MakeRequest({0, 18, 12, 25, 3, 4, 5})));
+  EquityRequest exact = request;
+  exact.n = 0;
+  EXPECT_NE(CanonicalKey(request), CanonicalKey(exact));
+}
+
+}  // namespace
+}  // namespace poker
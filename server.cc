@@ -0,0 +1,376 @@
+#include "server.h"
+
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "table.h"
+
+namespace poker {
+
+using ::absl::InternalError;
+using ::absl::Status;
+using ::absl::StatusOr;
+using ::absl::StrCat;
+using ::std::shared_ptr;
+using ::std::string;
+using ::std::vector;
+
+ThreadPool::ThreadPool(int num_threads) {
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this] { WorkLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    absl::MutexLock lock(&mu_);
+    stopping_ = true;
+  }
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadPool::Schedule(std::function<void()> work) {
+  absl::MutexLock lock(&mu_);
+  queue_.push_back(std::move(work));
+}
+
+void ThreadPool::WorkLoop() {
+  while (true) {
+    std::function<void()> work;
+    {
+      absl::MutexLock lock(&mu_);
+      mu_.Await(absl::Condition(
+          +[](ThreadPool *pool) ABSL_EXCLUSIVE_LOCKS_REQUIRED(pool->mu_) {
+            return pool->stopping_ || !pool->queue_.empty();
+          },
+          this));
+      if (queue_.empty()) {
+        return;
+      }
+      work = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    work();
+  }
+}
+
+// A client connection. Responses can be sent from any worker thread, so
+// writes are serialized, and the socket stays open until the last pending
+// response has been sent.
+struct EquityServer::Connection {
+  explicit Connection(int _fd) : fd(_fd) {}
+  ~Connection() { close(fd); }
+
+  void Send(const EquityResponse &response) {
+    absl::MutexLock lock(&write_mu);
+    // A failed write means the client went away; its reader will notice.
+    WriteFrame(fd, EncodeResponse(response)).IgnoreError();
+  }
+
+  const int fd;
+  absl::Mutex write_mu;
+};
+
+EquityServer::EquityServer(string socket_path, int num_threads,
+                           int cache_size)
+    : socket_path_(std::move(socket_path)),
+      cache_size_(cache_size),
+      pool_(num_threads) {
+  reaper_ = std::thread([this] { ReapLoop(); });
+}
+
+EquityServer::~EquityServer() {
+  Shutdown();
+  reaper_.join();
+}
+
+Status EquityServer::Run() {
+  const int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) {
+    return InternalError(StrCat("socket failed: ", strerror(errno)));
+  }
+
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  if (socket_path_.size() >= sizeof(addr.sun_path)) {
+    close(listen_fd);
+    return absl::InvalidArgumentError(
+        StrCat("Socket path too long: ", socket_path_));
+  }
+  strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+  // Remove a stale socket left by a previous run.
+  unlink(socket_path_.c_str());
+  if (bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+      listen(listen_fd, SOMAXCONN) < 0) {
+    const string error = strerror(errno);
+    close(listen_fd);
+    return InternalError(StrCat("Failed to listen on ", socket_path_, ": ",
+                                error));
+  }
+  {
+    absl::MutexLock lock(&mu_);
+    listen_fd_ = listen_fd;
+    if (stopping_) {
+      shutdown(listen_fd, SHUT_RDWR);
+    }
+  }
+
+  while (true) {
+    const int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd < 0 && (errno == EINTR || errno == ECONNABORTED)) {
+      continue;
+    }
+
+    absl::MutexLock lock(&mu_);
+    if (stopping_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+      close(listen_fd);
+      listen_fd_ = -1;
+      unlink(socket_path_.c_str());
+      return absl::OkStatus();
+    }
+    if (fd < 0) {
+      const string error = strerror(errno);
+      close(listen_fd);
+      listen_fd_ = -1;
+      return InternalError(StrCat("accept failed: ", error));
+    }
+    auto connection = std::make_shared<Connection>(fd);
+    connections_.insert(connection);
+    std::thread([this, connection] { ServeConnection(connection); })
+        .detach();
+  }
+}
+
+void EquityServer::Shutdown() {
+  absl::MutexLock lock(&mu_);
+  if (!stopping_) {
+    stopping_ = true;
+    // Wakes up accept() and every connection's read().
+    if (listen_fd_ >= 0) {
+      shutdown(listen_fd_, SHUT_RDWR);
+    }
+    for (const auto &connection : connections_) {
+      shutdown(connection->fd, SHUT_RDWR);
+    }
+    for (const auto &[key, job] : in_flight_) {
+      job->cancel->Cancel();
+    }
+    reaper_cv_.SignalAll();
+  }
+  mu_.Await(absl::Condition(
+      +[](EquityServer *server) ABSL_EXCLUSIVE_LOCKS_REQUIRED(server->mu_) {
+        return server->connections_.empty();
+      },
+      this));
+}
+
+bool EquityServer::IsCached(const EquityRequest &request) {
+  absl::MutexLock lock(&mu_);
+  return cache_.contains(CanonicalKey(request));
+}
+
+void EquityServer::ServeConnection(shared_ptr<Connection> connection) {
+  while (true) {
+    StatusOr<string> payload = ReadFrame(connection->fd);
+    if (!payload.ok()) {
+      if (!absl::IsOutOfRange(payload.status())) {
+        std::cerr << "Dropping connection: " << payload.status() << std::endl;
+      }
+      break;
+    }
+
+    StatusOr<EquityRequest> request = DecodeRequest(*payload);
+    if (!request.ok()) {
+      // The id is the first field, so echo it back if we got that far.
+      EquityResponse response;
+      if (payload->size() >= sizeof(response.request_id)) {
+        memcpy(&response.request_id, payload->data(),
+               sizeof(response.request_id));
+      }
+      response.code = request.status().code();
+      connection->Send(response);
+      continue;
+    }
+    HandleRequest(connection, *request);
+  }
+
+  absl::MutexLock lock(&mu_);
+  connections_.erase(connection);
+}
+
+void EquityServer::HandleRequest(const shared_ptr<Connection> &connection,
+                                 const EquityRequest &request) {
+  const string key = CanonicalKey(request);
+  // The deadline counts from when the request arrived, not from when a
+  // worker picks it up.
+  const absl::Time deadline =
+      request.deadline_ms == 0
+          ? absl::InfiniteFuture()
+          : absl::Now() + absl::Milliseconds(request.deadline_ms);
+  EquityResponse response;
+  response.request_id = request.request_id;
+  {
+    absl::MutexLock lock(&mu_);
+    auto cached = cache_.find(key);
+    if (cached == cache_.end()) {
+      std::shared_ptr<InFlight> &job = in_flight_[key];
+      if (job == nullptr) {
+        job = std::make_shared<InFlight>();
+        job->key = key;
+        pool_.Schedule([this, request, job] { Compute(request, job); });
+      }
+      job->waiters.push_back({connection, request.request_id, deadline});
+      if (deadline != absl::InfiniteFuture()) {
+        reaper_cv_.Signal();
+      }
+      return;
+    }
+    response.win = cached->second.win;
+    response.tie = cached->second.tie;
+    response.samples = cached->second.samples;
+  }
+  connection->Send(response);
+}
+
+void EquityServer::Compute(const EquityRequest &request,
+                           const shared_ptr<InFlight> &job) {
+  // Don't start a job whose waiters have all given up while it was queued.
+  vector<Answer> answers;
+  bool abandoned;
+  {
+    absl::MutexLock lock(&mu_);
+    ExpireLocked(job, absl::Now(), &answers);
+    abandoned = job->cancel->IsCancelled();
+  }
+  for (const auto &[waiter, response] : answers) {
+    waiter.connection->Send(response);
+  }
+  if (abandoned) {
+    return;
+  }
+
+  // No deadline on the job itself: it runs until it finishes or the reaper
+  // cancels it, and only publishes its estimate for the reaper to send.
+  EquityJobOptions options;
+  options.cancel = job->cancel;
+  options.progress_interval = absl::Milliseconds(1);
+  options.on_progress = [this, &job](const EquityResult &progress) {
+    absl::MutexLock lock(&mu_);
+    job->progress = progress;
+  };
+  const StatusOr<EquityResult> odds =
+      RunWinPercentage(request.n, request.Self(), request.Opponent(),
+                       request.Board(), options);
+
+  vector<Waiter> waiters;
+  {
+    absl::MutexLock lock(&mu_);
+    waiters = std::move(job->waiters);
+    job->waiters.clear();
+    auto it = in_flight_.find(job->key);
+    // The entry may already belong to a newer job if this one was cancelled.
+    if (it != in_flight_.end() && it->second == job) {
+      in_flight_.erase(it);
+    }
+    if (odds.ok() && odds->code == absl::StatusCode::kOk && request.n == 0 &&
+        cache_size_ > 0) {
+      if (static_cast<int>(cache_.size()) >= cache_size_) {
+        cache_.erase(cache_order_.front());
+        cache_order_.pop_front();
+      }
+      if (cache_.emplace(job->key, *odds).second) {
+        cache_order_.push_back(job->key);
+      }
+    }
+  }
+
+  EquityResponse response;
+  response.code = odds.status().code();
+  if (odds.ok()) {
+    response.code = odds->code;
+    response.win = odds->win;
+    response.tie = odds->tie;
+    response.samples = odds->samples;
+  }
+  for (const auto &waiter : waiters) {
+    response.request_id = waiter.request_id;
+    waiter.connection->Send(response);
+  }
+}
+
+void EquityServer::ExpireLocked(const shared_ptr<InFlight> &job,
+                                absl::Time now, vector<Answer> *answers) {
+  vector<Waiter> &waiters = job->waiters;
+  auto expired = std::partition(
+      waiters.begin(), waiters.end(),
+      [now](const Waiter &waiter) { return waiter.deadline > now; });
+  for (auto it = expired; it != waiters.end(); ++it) {
+    EquityResponse response;
+    response.request_id = it->request_id;
+    response.code = absl::StatusCode::kDeadlineExceeded;
+    response.win = job->progress.win;
+    response.tie = job->progress.tie;
+    response.samples = job->progress.samples;
+    answers->emplace_back(std::move(*it), response);
+  }
+  waiters.erase(expired, waiters.end());
+
+  if (waiters.empty()) {
+    // Nobody needs the rest. Later requests start a new job.
+    job->cancel->Cancel();
+    auto it = in_flight_.find(job->key);
+    if (it != in_flight_.end() && it->second == job) {
+      in_flight_.erase(it);
+    }
+  }
+}
+
+void EquityServer::ReapLoop() {
+  absl::MutexLock lock(&mu_);
+  while (!stopping_) {
+    const absl::Time now = absl::Now();
+    // Copied since expiring a job can remove it from in_flight_.
+    vector<shared_ptr<InFlight>> jobs;
+    for (const auto &[key, job] : in_flight_) {
+      jobs.push_back(job);
+    }
+
+    vector<Answer> answers;
+    absl::Time next_deadline = absl::InfiniteFuture();
+    for (const auto &job : jobs) {
+      ExpireLocked(job, now, &answers);
+      for (const auto &waiter : job->waiters) {
+        next_deadline = std::min(next_deadline, waiter.deadline);
+      }
+    }
+
+    if (!answers.empty()) {
+      // Don't hold up everyone else while writing to clients.
+      mu_.Unlock();
+      for (const auto &[waiter, response] : answers) {
+        waiter.connection->Send(response);
+      }
+      mu_.Lock();
+      continue;
+    }
+    reaper_cv_.WaitWithDeadline(&mu_, next_deadline);
+  }
+}
+
+}  // namespace poker
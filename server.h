@@ -0,0 +1,131 @@
+#ifndef SERVER
+#define SERVER
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "job.h"
+#include "protocol.h"
+
+namespace poker {
+
+// Fixed size pool of worker threads draining a FIFO queue.
+class ThreadPool {
+ public:
+  explicit ThreadPool(int num_threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  void Schedule(std::function<void()> work);
+
+ private:
+  void WorkLoop();
+
+  absl::Mutex mu_;
+  std::deque<std::function<void()>> queue_ ABSL_GUARDED_BY(mu_);
+  bool stopping_ ABSL_GUARDED_BY(mu_) = false;
+  std::vector<std::thread> threads_;
+};
+
+// Answers equity queries from local clients over a Unix domain socket.
+//
+// All connections share one thread pool and one cache of exact results.
+// Identical queries that arrive while one is being computed are coalesced:
+// only the first is run, and every waiter gets the same answer. A query with
+// a deadline is answered with the partial odds computed so far once its own
+// deadline passes, even if its job is still waiting for a worker, while the
+// shared job keeps running for the other waiters. The job is cancelled once
+// nobody is left waiting on it.
+class EquityServer {
+ public:
+  EquityServer(std::string socket_path, int num_threads, int cache_size);
+  ~EquityServer();
+
+  EquityServer(const EquityServer &) = delete;
+  EquityServer &operator=(const EquityServer &) = delete;
+
+  // Binds the socket and serves connections until the listener fails or
+  // Shutdown() is called.
+  absl::Status Run();
+
+  // Stops accepting, closes every connection and cancels running jobs.
+  void Shutdown();
+
+  // Whether the exact odds for `request` are in the cache.
+  bool IsCached(const EquityRequest &request);
+
+ private:
+  struct Connection;
+
+  struct Waiter {
+    std::shared_ptr<Connection> connection;
+    uint32_t request_id;
+    absl::Time deadline;
+  };
+
+  // A query being computed. Fields are guarded by mu_.
+  struct InFlight {
+    std::string key;
+    std::vector<Waiter> waiters;
+    // The job's latest estimate, sent to waiters whose deadline passes.
+    EquityResult progress;
+    std::shared_ptr<CancellationToken> cancel =
+        std::make_shared<CancellationToken>();
+  };
+
+  using Answer = std::pair<Waiter, EquityResponse>;
+
+  void ServeConnection(std::shared_ptr<Connection> connection);
+  void HandleRequest(const std::shared_ptr<Connection> &connection,
+                     const EquityRequest &request);
+  void Compute(const EquityRequest &request,
+               const std::shared_ptr<InFlight> &job);
+  // Removes the waiters on `job` whose deadline is not after `now` and adds
+  // their partial answers to `answers`. Cancels the job if nobody is left.
+  void ExpireLocked(const std::shared_ptr<InFlight> &job, absl::Time now,
+                    std::vector<Answer> *answers)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Answers waiters as their deadlines pass, independent of job progress.
+  void ReapLoop();
+
+  const std::string socket_path_;
+  const int cache_size_;
+
+  absl::Mutex mu_;
+  // Woken when a waiter with a deadline arrives or on shutdown.
+  absl::CondVar reaper_cv_;
+  bool stopping_ ABSL_GUARDED_BY(mu_) = false;
+  int listen_fd_ ABSL_GUARDED_BY(mu_) = -1;
+  absl::flat_hash_set<std::shared_ptr<Connection>> connections_
+      ABSL_GUARDED_BY(mu_);
+  // Queries being computed, and the clients waiting on them.
+  absl::flat_hash_map<std::string, std::shared_ptr<InFlight>> in_flight_
+      ABSL_GUARDED_BY(mu_);
+  // Exact odds never change, so they are kept around. Monte-Carlo results
+  // are only shared while in flight. Once full, the oldest entry in
+  // `cache_order_` is evicted first.
+  absl::flat_hash_map<std::string, EquityResult> cache_
+      ABSL_GUARDED_BY(mu_);
+  std::deque<std::string> cache_order_ ABSL_GUARDED_BY(mu_);
+
+  std::thread reaper_;
+  // Last, so workers are joined before the state they use is destroyed.
+  ThreadPool pool_;
+};
+
+}  // namespace poker
+
+#endif // SERVER
@@ -0,0 +1,55 @@
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/status/status.h"
+#include "server.h"
+
+ABSL_FLAG(std::string, socket, "/tmp/poker.sock",
+          "Path of the Unix domain socket to listen on.");
+ABSL_FLAG(int, threads, 0,
+          "Number of worker threads. Defaults to the number of cores.");
+ABSL_FLAG(int, cache_size, 100000,
+          "Maximum number of exact results to keep, evicting the oldest "
+          "first. 0 disables the cache.");
+
+namespace {
+
+// Set before the signal handlers are installed.
+std::string socket_path;
+
+// Removes the socket file so it isn't left behind on shutdown.
+void HandleShutdown(int signum) {
+  unlink(socket_path.c_str());
+  _exit(128 + signum);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  absl::ParseCommandLine(argc, argv);
+  // Clients that hang up are handled when writing to them.
+  signal(SIGPIPE, SIG_IGN);
+  socket_path = absl::GetFlag(FLAGS_socket);
+  signal(SIGINT, HandleShutdown);
+  signal(SIGTERM, HandleShutdown);
+
+  int threads = absl::GetFlag(FLAGS_threads);
+  if (threads <= 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  poker::EquityServer server(socket_path, threads,
+                             absl::GetFlag(FLAGS_cache_size));
+  std::cout << "Serving on " << socket_path << " with " << threads
+            << " threads" << std::endl;
+  const absl::Status status = server.Run();
+  std::cout << status.message() << std::endl;
+  return 1;
+}
@@ -0,0 +1,196 @@
+#include "server.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+#include "protocol.h"
+#include "table.h"
+
+namespace poker {
+namespace {
+
+const std::pair<Card, Card> kAces = {Card(Suit(0), Rank(12)),
+                                     Card(Suit(1), Rank(12))};
+const std::pair<Card, Card> kSevenDeuce = {Card(Suit(2), Rank(0)),
+                                           Card(Suit(3), Rank(5))};
+const std::pair<Card, Card> kKings = {Card(Suit(0), Rank(11)),
+                                      Card(Suit(1), Rank(11))};
+
+EquityRequest MakeRequest(uint32_t request_id, int n, uint32_t deadline_ms,
+                          const std::pair<Card, Card> &self,
+                          const std::vector<Card> &board = {}) {
+  EquityRequest request;
+  request.request_id = request_id;
+  request.n = n;
+  request.deadline_ms = deadline_ms;
+  request.cards.push_back(self.first);
+  request.cards.push_back(self.second);
+  request.cards.push_back(kSevenDeuce.first);
+  request.cards.push_back(kSevenDeuce.second);
+  for (const auto &card : board) {
+    request.cards.push_back(card);
+  }
+  return request;
+}
+
+// Two turns that leave both hands live.
+std::vector<Card> Turn(int last_rank) {
+  return {Card(Suit(3), Rank(0)), Card(Suit(1), Rank(5)),
+          Card(Suit(2), Rank(5)), Card(Suit(0), Rank(last_rank))};
+}
+
+// Runs an EquityServer on a temporary socket for the length of a test.
+class TestServer {
+ public:
+  TestServer(int num_threads, int cache_size)
+      : path_(testing::TempDir() + "/equity_server_test.sock"),
+        server_(path_, num_threads, cache_size),
+        runner_([this] { EXPECT_TRUE(server_.Run().ok()); }) {}
+
+  ~TestServer() {
+    server_.Shutdown();
+    runner_.join();
+  }
+
+  EquityServer &server() { return server_; }
+
+  // Returns a connected client socket, retrying until Run() is listening.
+  int Connect() {
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path_.c_str(), sizeof(addr.sun_path) - 1);
+    for (int attempt = 0; attempt < 500; ++attempt) {
+      const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+      if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) ==
+          0) {
+        return fd;
+      }
+      close(fd);
+      absl::SleepFor(absl::Milliseconds(10));
+    }
+    ADD_FAILURE() << "Could not connect to " << path_;
+    return -1;
+  }
+
+ private:
+  const std::string path_;
+  EquityServer server_;
+  std::thread runner_;
+};
+
+void Send(int fd, const EquityRequest &request) {
+  ASSERT_TRUE(WriteFrame(fd, EncodeRequest(request)).ok());
+}
+
+EquityResponse Receive(int fd) {
+  const absl::StatusOr<std::string> payload = ReadFrame(fd);
+  EXPECT_TRUE(payload.ok()) << payload.status();
+  if (!payload.ok()) {
+    return EquityResponse();
+  }
+  const absl::StatusOr<EquityResponse> response = DecodeResponse(*payload);
+  EXPECT_TRUE(response.ok()) << response.status();
+  return response.ok() ? *response : EquityResponse();
+}
+
+TEST(EquityServerTest, DeadlineWaiterLeavesSharedJobRunning) {
+  TestServer test(1, 16);
+  const int fd = test.Connect();
+  ASSERT_GE(fd, 0);
+
+  // One connection, so the second request is sure to join the first's job.
+  const absl::Time start = absl::Now();
+  Send(fd, MakeRequest(1, 50000, 0, kAces));
+  Send(fd, MakeRequest(2, 50000, 50, kAces));
+
+  const EquityResponse partial = Receive(fd);
+  EXPECT_LT(absl::Now() - start, absl::Milliseconds(500));
+  EXPECT_EQ(partial.request_id, 2u);
+  EXPECT_EQ(partial.code, absl::StatusCode::kDeadlineExceeded);
+  EXPECT_LT(partial.samples, 50000u);
+
+  const EquityResponse full = Receive(fd);
+  EXPECT_EQ(full.request_id, 1u);
+  EXPECT_EQ(full.code, absl::StatusCode::kOk);
+  EXPECT_EQ(full.samples, 50000u);
+  EXPECT_NEAR(full.win, 0.8724, 0.02);
+  close(fd);
+}
+
+TEST(EquityServerTest, DeadlineHoldsWhileQueued) {
+  TestServer test(1, 16);
+  const int fd = test.Connect();
+  ASSERT_GE(fd, 0);
+
+  // Exact preflop odds keep the only worker busy until shutdown.
+  Send(fd, MakeRequest(1, 0, 0, kAces));
+  const absl::Time start = absl::Now();
+  Send(fd, MakeRequest(2, 0, 50, kKings, Turn(0)));
+
+  const EquityResponse response = Receive(fd);
+  EXPECT_LT(absl::Now() - start, absl::Milliseconds(500));
+  EXPECT_EQ(response.request_id, 2u);
+  EXPECT_EQ(response.code, absl::StatusCode::kDeadlineExceeded);
+  EXPECT_EQ(response.samples, 0u);
+  close(fd);
+}
+
+TEST(EquityServerTest, ExpiredJobIsCancelledAndNotCached) {
+  TestServer test(1, 16);
+  const int fd = test.Connect();
+  ASSERT_GE(fd, 0);
+
+  const EquityRequest preflop = MakeRequest(1, 0, 50, kAces);
+  Send(fd, preflop);
+  Send(fd, MakeRequest(2, 0, 50, kAces));
+  for (int i = 0; i < 2; ++i) {
+    const EquityResponse response = Receive(fd);
+    EXPECT_EQ(response.code, absl::StatusCode::kDeadlineExceeded);
+    EXPECT_LT(response.samples, 1712304u);
+  }
+
+  // The worker is free again: a turn is answered long before the preflop
+  // job could have finished.
+  const absl::Time start = absl::Now();
+  Send(fd, MakeRequest(3, 0, 0, kAces, Turn(0)));
+  const EquityResponse turn = Receive(fd);
+  EXPECT_LT(absl::Now() - start, absl::Seconds(5));
+  EXPECT_EQ(turn.request_id, 3u);
+  EXPECT_EQ(turn.code, absl::StatusCode::kOk);
+  EXPECT_EQ(turn.samples, 44u);
+
+  EXPECT_FALSE(test.server().IsCached(preflop));
+  close(fd);
+}
+
+TEST(EquityServerTest, CacheEvictsOldestFirst) {
+  TestServer test(1, 1);
+  const int fd = test.Connect();
+  ASSERT_GE(fd, 0);
+
+  const EquityRequest first = MakeRequest(1, 0, 0, kAces, Turn(0));
+  const EquityRequest second = MakeRequest(2, 0, 0, kAces, Turn(1));
+  Send(fd, first);
+  EXPECT_EQ(Receive(fd).code, absl::StatusCode::kOk);
+  EXPECT_TRUE(test.server().IsCached(first));
+
+  Send(fd, second);
+  EXPECT_EQ(Receive(fd).code, absl::StatusCode::kOk);
+  EXPECT_TRUE(test.server().IsCached(second));
+  EXPECT_FALSE(test.server().IsCached(first));
+  close(fd);
+}
+
+}  // namespace
+}  // namespace poker
@@ -0,0 +1,207 @@
+#include "sweep.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "combinations.h"
+#include "table.h"
+
+namespace poker {
+
+using ::absl::InvalidArgumentError;
+using ::absl::OkStatus;
+using ::absl::Status;
+using ::absl::StatusOr;
+using ::absl::StrCat;
+using ::std::pair;
+using ::std::string;
+using ::std::vector;
+
+namespace {
+
+struct Tally {
+  vector<uint32_t> wins;
+  vector<uint32_t> ties;
+};
+
+string ShortString(const vector<Card> &cards) {
+  static const char kRanks[] = "23456789TJQKA";
+  static const char kSuits[] = "shdc";
+  string result;
+  for (const auto &card : cards) {
+    result += kRanks[card.rank.rank];
+    result += kSuits[card.suit.suit];
+  }
+  return result;
+}
+
+}  // namespace
+
+StatusOr<vector<BoardEquity>> SweepBoards(const pair<Card, Card> &self,
+                                          const pair<Card, Card> &opponent,
+                                          const vector<Card> &board,
+                                          int street, int num_threads) {
+  if (board.size() != 0 && (board.size() < 3 || board.size() > 4)) {
+    return InvalidArgumentError(
+        StrCat("Can't sweep from a board of size ", board.size()));
+  }
+  if (street < 3 || street > 5 || street <= static_cast<int>(board.size())) {
+    return InvalidArgumentError(StrCat("Bad street: ", street));
+  }
+
+  vector<Card> deck = GetAllPossibleCards();
+  vector<Card> dead = {self.first, self.second, opponent.first,
+                       opponent.second};
+  for (const auto &card : board) {
+    dead.push_back(card);
+  }
+  for (const auto &card : dead) {
+    if (!DeleteCard(&deck, card).ok()) {
+      return InvalidArgumentError(
+          StrCat("Invalid or duplicate card: ", DebugString(card)));
+    }
+  }
+
+  const int deck_size = deck.size();
+  // Cards needed to reach the river, and how many of those make up a street.
+  const int runout_size = 5 - board.size();
+  const int swept_size = street - board.size();
+  const uint32_t num_boards = Choose(deck_size, swept_size);
+
+  // Every way of picking the swept cards out of a runout.
+  vector<vector<int>> picks;
+  vector<int> pick(swept_size);
+  for (int i = 0; i < swept_size; ++i) {
+    pick[i] = i;
+  }
+  do {
+    picks.push_back(pick);
+  } while (NextCombination(&pick, runout_size));
+
+  num_threads = std::max(1, num_threads);
+  vector<Tally> tallies(num_threads);
+  vector<Status> statuses(num_threads);
+  // Runouts are split by their lowest card and handed out on demand, since
+  // lower cards lead many more runouts.
+  std::atomic<int> next_first(0);
+  auto work = [&](int thread) {
+    Tally &tally = tallies[thread];
+    tally.wins.assign(num_boards, 0);
+    tally.ties.assign(num_boards, 0);
+    vector<Card> full_board = board;
+    vector<int> swept(swept_size);
+
+    for (int first = next_first++; first <= deck_size - runout_size;
+         first = next_first++) {
+      vector<int> rest(runout_size - 1);
+      for (size_t i = 0; i < rest.size(); ++i) {
+        rest[i] = first + 1 + i;
+      }
+      do {
+        vector<int> runout = {first};
+        runout.insert(runout.end(), rest.begin(), rest.end());
+        full_board.erase(full_board.begin() + board.size(), full_board.end());
+        for (const int index : runout) {
+          full_board.push_back(deck[index]);
+        }
+
+        const StatusOr<int> compare = CompareHands(self, opponent, full_board);
+        if (!compare.ok()) {
+          statuses[thread] = compare.status();
+          return;
+        }
+        if (*compare == 1) {
+          continue;
+        }
+        for (const auto &positions : picks) {
+          for (int i = 0; i < swept_size; ++i) {
+            swept[i] = runout[positions[i]];
+          }
+          const uint32_t rank = ColexRank(swept);
+          tally.wins[rank] += *compare == -1 ? 1 : 0;
+          tally.ties[rank] += *compare == 0 ? 1 : 0;
+        }
+      } while (NextCombination(&rest, deck_size));
+    }
+  };
+
+  vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back(work, i);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (const auto &status : statuses) {
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  // Each street board can be completed in this many ways.
+  const uint32_t total = Choose(deck_size - swept_size,
+                                runout_size - swept_size);
+  vector<BoardEquity> results;
+  results.reserve(num_boards);
+  vector<int> swept(swept_size);
+  for (int i = 0; i < swept_size; ++i) {
+    swept[i] = i;
+  }
+  do {
+    BoardEquity result{board};
+    for (const int index : swept) {
+      result.board.push_back(deck[index]);
+    }
+    const uint32_t rank = ColexRank(swept);
+    for (const auto &tally : tallies) {
+      result.wins += tally.wins[rank];
+      result.ties += tally.ties[rank];
+    }
+    result.total = total;
+    results.push_back(std::move(result));
+  } while (NextCombination(&swept, deck_size));
+
+  return results;
+}
+
+Status WriteSweepCsv(const vector<BoardEquity> &results, std::ostream *out) {
+  *out << "board,win,tie,wins,ties,total\n";
+  for (const auto &result : results) {
+    *out << ShortString(result.board) << ','
+         << static_cast<double>(result.wins) / result.total << ','
+         << static_cast<double>(result.ties) / result.total << ','
+         << result.wins << ',' << result.ties << ',' << result.total << '\n';
+  }
+  out->flush();
+  return out->good() ? OkStatus() : absl::InternalError("Failed to write CSV");
+}
+
+Status WriteSweepBinary(const vector<BoardEquity> &results,
+                        std::ostream *out) {
+  const uint8_t version = 1;
+  const uint8_t board_size = results.empty() ? 0 : results[0].board.size();
+  out->write("PKSW", 4);
+  out->write(reinterpret_cast<const char *>(&version), sizeof(version));
+  out->write(reinterpret_cast<const char *>(&board_size), sizeof(board_size));
+  for (const auto &result : results) {
+    for (const auto &card : result.board) {
+      const uint8_t byte = EncodeCard(card);
+      out->write(reinterpret_cast<const char *>(&byte), sizeof(byte));
+    }
+    for (const uint32_t count : {result.wins, result.ties, result.total}) {
+      out->write(reinterpret_cast<const char *>(&count), sizeof(count));
+    }
+  }
+  out->flush();
+  return out->good() ? OkStatus()
+                     : absl::InternalError("Failed to write sweep");
+}
+
+}  // namespace poker
@@ -0,0 +1,47 @@
+#ifndef SWEEP
+#define SWEEP
+
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "table.h"
+
+namespace poker {
+
+// Exact odds for one board reached by a sweep.
+struct BoardEquity {
+  std::vector<Card> board;
+  uint32_t wins = 0;
+  uint32_t ties = 0;
+  uint32_t total = 0;  // Number of runouts from this board to the river.
+};
+
+// Computes exact odds of a fixed matchup for every board that extends
+// `board` to `street` cards (3 for every flop, 4 for every turn, 5 for every
+// river). Results are sorted by the added cards in GetAllPossibleCards()
+// order.
+//
+// Rather than enumerating runouts per board, every river board is evaluated
+// once and credited to each of the street boards it contains, so a full flop
+// sweep costs one pass over the C(48, 5) runouts instead of C(48, 3) * 990.
+absl::StatusOr<std::vector<BoardEquity>> SweepBoards(
+    const std::pair<Card, Card> &self, const std::pair<Card, Card> &opponent,
+    const std::vector<Card> &board, int street, int num_threads);
+
+// One line per board, e.g. "Ah7d2c,0.872,0.003,861,3,990", after a header.
+absl::Status WriteSweepCsv(const std::vector<BoardEquity> &results,
+                           std::ostream *out);
+
+// A "PKSW" magic, a uint8 version and a uint8 cards per board, followed by
+// one record per board: the board's cards encoded with EncodeCard(), then
+// uint32 wins, ties and total in host byte order.
+absl::Status WriteSweepBinary(const std::vector<BoardEquity> &results,
+                              std::ostream *out);
+
+}  // namespace poker
+
+#endif // SWEEP
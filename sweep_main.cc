@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "sweep.h"
+#include "table.h"
+
+ABSL_FLAG(std::string, self, "", "Your cards, e.g. \"s,14;h,14\".");
+ABSL_FLAG(std::string, opp, "", "Opponent's cards in the above format.");
+ABSL_FLAG(std::string, board, "",
+          "Board to sweep from in the above format. Must have 0, 3 or 4 "
+          "cards.");
+ABSL_FLAG(std::string, street, "flop",
+          "Which boards to sweep: flop, turn or river.");
+ABSL_FLAG(std::string, out, "", "File to write results to.");
+ABSL_FLAG(std::string, format, "csv", "Output format: csv or binary.");
+ABSL_FLAG(int, threads, 0,
+          "Number of worker threads. Defaults to the number of cores.");
+
+namespace poker {
+
+absl::Status Sweep() {
+  const std::string street_str = absl::GetFlag(FLAGS_street);
+  const int street = street_str == "flop"    ? 3
+                     : street_str == "turn"  ? 4
+                     : street_str == "river" ? 5 : 0;
+  if (street == 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unknown street: ", street_str));
+  }
+  const std::string format = absl::GetFlag(FLAGS_format);
+  if (format != "csv" && format != "binary") {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unknown format: ", format));
+  }
+
+  absl::StatusOr<std::vector<Card>> self =
+      MapCardsString(absl::GetFlag(FLAGS_self));
+  if (!self.ok()) {
+    return self.status();
+  }
+  absl::StatusOr<std::vector<Card>> opponent =
+      MapCardsString(absl::GetFlag(FLAGS_opp));
+  if (!opponent.ok()) {
+    return opponent.status();
+  }
+  if (self->size() != 2 || opponent->size() != 2) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Failed to parse self or opponent hands. Self: ",
+                     absl::GetFlag(FLAGS_self), ". Opponent: ",
+                     absl::GetFlag(FLAGS_opp)));
+  }
+  absl::StatusOr<std::vector<Card>> board =
+      MapCardsString(absl::GetFlag(FLAGS_board));
+  if (!board.ok()) {
+    return board.status();
+  }
+
+  int threads = absl::GetFlag(FLAGS_threads);
+  if (threads <= 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  const absl::StatusOr<std::vector<BoardEquity>> results =
+      SweepBoards({(*self)[0], (*self)[1]}, {(*opponent)[0], (*opponent)[1]},
+                  *board, street, threads);
+  if (!results.ok()) {
+    return results.status();
+  }
+
+  std::ofstream out(absl::GetFlag(FLAGS_out), std::ios::binary);
+  if (!out) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Can't open output file: ", absl::GetFlag(FLAGS_out)));
+  }
+  std::cout << "Writing " << results->size() << " boards to "
+            << absl::GetFlag(FLAGS_out) << std::endl;
+  return format == "csv" ? WriteSweepCsv(*results, &out)
+                         : WriteSweepBinary(*results, &out);
+}
+
+}  // namespace poker
+
+int main(int argc, char* argv[]) {
+  absl::ParseCommandLine(argc, argv);
+  const absl::Status status = poker::Sweep();
+  if (!status.ok()) {
+    std::cout << status.message() << std::endl;
+    return 1;
+  }
+  return 0;
+}
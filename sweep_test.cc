@@ -0,0 +1,84 @@
+#include "sweep.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "table.h"
+
+namespace poker {
+namespace {
+
+const std::pair<Card, Card> kAces = {Card(Suit(0), Rank(12)),
+                                     Card(Suit(1), Rank(12))};
+const std::pair<Card, Card> kSevenDeuce = {Card(Suit(2), Rank(0)),
+                                           Card(Suit(3), Rank(5))};
+
+int NumThreads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Checks a swept board against a separate backtracking run on it.
+void ExpectMatchesWinPercentage(const BoardEquity &result) {
+  const auto odds = WinPercentage(kAces, kSevenDeuce, result.board);
+  ASSERT_TRUE(odds.ok()) << odds.status();
+  EXPECT_DOUBLE_EQ(static_cast<double>(result.wins) / result.total,
+                   odds->first)
+      << DebugString(result.board);
+  EXPECT_DOUBLE_EQ(static_cast<double>(result.ties) / result.total,
+                   odds->second)
+      << DebugString(result.board);
+}
+
+TEST(SweepTest, TurnsMatchWinPercentage) {
+  const std::vector<Card> flop = {Card(Suit(0), Rank(0)),
+                                  Card(Suit(1), Rank(5)),
+                                  Card(Suit(2), Rank(5))};
+  const auto results =
+      SweepBoards(kAces, kSevenDeuce, flop, 4, NumThreads());
+  ASSERT_TRUE(results.ok()) << results.status();
+  ASSERT_EQ(results->size(), 45u);
+  for (const auto &result : *results) {
+    ASSERT_EQ(result.board.size(), 4u);
+    EXPECT_EQ(result.total, 44u);
+    ExpectMatchesWinPercentage(result);
+  }
+}
+
+TEST(SweepTest, FlopsMatchWinPercentage) {
+  const auto results =
+      SweepBoards(kAces, kSevenDeuce, {}, 3, NumThreads());
+  ASSERT_TRUE(results.ok()) << results.status();
+  ASSERT_EQ(results->size(), 17296u);
+
+  // Sorted by board, in GetAllPossibleCards() order.
+  for (size_t i = 1; i < results->size(); ++i) {
+    std::vector<uint8_t> previous, current;
+    for (const auto &card : (*results)[i - 1].board) {
+      previous.push_back(EncodeCard(card));
+    }
+    for (const auto &card : (*results)[i].board) {
+      current.push_back(EncodeCard(card));
+    }
+    ASSERT_LT(previous, current);
+  }
+
+  for (const int i : {0, 1, 4321, 9999, 17295}) {
+    EXPECT_EQ((*results)[i].total, 990u);
+    ExpectMatchesWinPercentage((*results)[i]);
+  }
+}
+
+TEST(SweepTest, RejectsBadInput) {
+  const std::vector<Card> flop = {Card(Suit(0), Rank(12)),
+                                  Card(Suit(1), Rank(5)),
+                                  Card(Suit(2), Rank(5))};
+  // The flop reuses one of our aces.
+  EXPECT_FALSE(SweepBoards(kAces, kSevenDeuce, flop, 4, 1).ok());
+  EXPECT_FALSE(SweepBoards(kAces, kSevenDeuce, {}, 6, 1).ok());
+}
+
+}  // namespace
+}  // namespace poker
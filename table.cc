@@ -10,9 +10,12 @@
 #include <vector>
 #include <iostream>
 #include <cstdlib>
+#include <set>
 
 #include "absl/strings/str_cat.h"
 #include "absl/status/status.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
 
 namespace poker {
 
@@ -25,6 +28,7 @@ using ::std::to_string;
 using ::absl::Status;
 using ::absl::StatusOr;
 using ::absl::InternalError;
+using ::absl::InvalidArgumentError;
 using ::absl::OkStatus;
 using ::absl::StrCat;
 
@@ -42,6 +46,60 @@ std::vector<Card> GetAllPossibleCards() {
   return cards;
 }
 
+uint8_t EncodeCard(const Card &card) {
+  return card.suit.suit * 13 + card.rank.rank;
+}
+
+StatusOr<Card> DecodeCard(uint8_t byte) {
+  if (byte >= 52) {
+    return InvalidArgumentError(
+        StrCat("Invalid card: ", static_cast<int>(byte)));
+  }
+  return Card(Suit(byte / 13), Rank(byte % 13));
+}
+
+StatusOr<Card> MapCardString(const std::string &card) {
+  const std::pair<std::string, std::string> pair_str =
+      absl::StrSplit(card, ',', absl::SkipEmpty());
+
+  const std::string suit_str = pair_str.first;
+  const std::set<std::string> possible_suits({"s", "h", "d", "c"});
+  if (possible_suits.find(suit_str) == possible_suits.end()) {
+      return InvalidArgumentError(
+          StrCat("Invalid suit", suit_str));
+  }
+
+  const Suit suit(suit_str == "s"   ? Suit(0)
+                  : suit_str == "h" ? Suit(1)
+                  : suit_str == "d" ? Suit(2)
+                  : suit_str == "c" ? Suit(3) : Suit(4)); // Impossible
+  
+  int rank_num;
+   // Parse the string into an integer.
+  const std::string &rank_str = pair_str.second;
+  if (!absl::SimpleAtoi(rank_str, &rank_num)) {
+      return InvalidArgumentError(
+          StrCat("Invalid rank", rank_str));
+  }
+
+  return Card(suit, Rank(rank_num - 2));
+}
+
+StatusOr<std::vector<Card>> MapCardsString(const std::string &cards) {
+  const std::vector<std::string> cards_str =
+      absl::StrSplit(cards, ';', absl::SkipEmpty());
+  std::vector<Card> result;
+  result.reserve(cards_str.size());
+  for (const auto &card_str : cards_str) {
+    StatusOr<Card> card = MapCardString(card_str);
+    if (!card.ok()) {
+      return card.status();
+    }
+    result.push_back(*card);
+  }
+  return result;
+}
+
 Status DeleteCard(std::vector<Card> *deck, const Card &card) {
   if (deck == nullptr) {
       return InternalError("Deck is nullptr");
@@ -1,7 +1,9 @@
 #ifndef TABLE
 #define TABLE
 
+#include <cstdint>
 #include <functional>
+#include <string>
 #include <vector>
 #include <algorithm>
 
@@ -76,6 +78,17 @@ struct Card {
 
 std::vector<Card> GetAllPossibleCards();
 
+// Encodes a card as a byte, suit * 13 + rank, which is its index in
+// GetAllPossibleCards().
+uint8_t EncodeCard(const Card &card);
+absl::StatusOr<Card> DecodeCard(uint8_t byte);
+
+// Parses a card given as a comma separated suit (s,h,d,c) / rank (2-14) pair.
+absl::StatusOr<Card> MapCardString(const std::string &card);
+
+// Parses a semi-colon separated list of cards in the above format.
+absl::StatusOr<std::vector<Card>> MapCardsString(const std::string &cards);
+
 // TODO: Add tests.
 // Returns 9 if the hand has a straight flush, -1 otherwise.
 std::vector<Card> HasStraightFlush(const std::vector<Card> &hand);